@@ -1,4 +1,5 @@
 #include "samd51_feather_m4_strobe.h"
+#include "samd51_init.h"
 
 #if __has_include(<component-version.h>)
 /* as invoked by Makefile, regardless of cmsis-atmel version */
@@ -10,68 +11,103 @@
 #include <samd51/include/samd51.h>
 #endif
 
-/* this function MUST live in .data, otherwise instruction timing after wake from deep sleep
- is nondeterministic, which usually results in the MSB being garbled */
-__attribute__((noinline, section(".ramfunc")))
-static void single_ws2812_set_grb(const uint32_t grb) {
-    /* 166 ns is the gcd of the 3 delays we need, at both CPU speeds we use */
-#if F_CPU >= 120000000
-#define NOPS_166NS "nop;nop;nop;nop;nop;nop;nop;nop;nop;nop;nop;nop;nop;nop;nop;nop;nop;nop;nop;nop;"
-#elif F_CPU == 48000000
-#define NOPS_166NS "nop;nop;nop;nop;nop;nop;nop;nop;"
-#endif
-
-    __disable_irq();
-
-    /* loop over bits in the 24-bit GRB triplet, msb first */
-    for (uint32_t bit = 1U << 23; bit; bit >>=1)
-        if (grb & bit) {
-            /* raise pin */
-            PORT->Group[1].OUTSET.reg = 1U << 3;
+/* after the device header, so that it can check the configuration against this part */
+#include "samd51_strobe_config.h"
 
-            /* datasheet says 700 +/- 150 ns, empirically > 500 ns */
-            asm volatile(NOPS_166NS NOPS_166NS NOPS_166NS NOPS_166NS :::);
+/* 166 ns is the gcd of the 3 delays we need, at both CPU speeds we use */
+#define NOPS_166NS_AT_48MHZ "nop;nop;nop;nop;nop;nop;nop;nop;"
+#define NOPS_166NS_AT_120MHZ "nop;nop;nop;nop;nop;nop;nop;nop;nop;nop;nop;nop;nop;nop;nop;nop;nop;nop;nop;nop;"
 
-            /* lower pin */
-            PORT->Group[1].OUTCLR.reg = 1U << 3;
-
-            /* datasheet says 600 +/- 150 ns, empirically > 16 ns */
-            asm volatile(NOPS_166NS NOPS_166NS NOPS_166NS :::);
-        } else {
-            PORT->Group[1].OUTSET.reg = 1U << 3;
-
-            /* datasheet says 350 +/- 150 ns, empirically > 33 and < 500 ns */
-            asm volatile(NOPS_166NS NOPS_166NS :::);
-
-            PORT->Group[1].OUTCLR.reg = 1U << 3;
+/* the cpu speed can now change at runtime, so emit one copy of the bit-banging loop per speed.
+ these functions MUST live in .data, otherwise instruction timing after wake from deep sleep
+ is nondeterministic, which usually results in the MSB being garbled */
+#define DEFINE_SINGLE_WS2812_SET_GRB(name, NOPS_166NS) \
+__attribute__((noinline, section(".ramfunc"))) \
+static void name(const uint32_t grb) { \
+    __disable_irq(); \
+\
+    /* loop over bits in the 24-bit GRB triplet, msb first */ \
+    for (uint32_t bit = 1U << 23; bit; bit >>=1) \
+        if (grb & bit) { \
+            /* raise pin */ \
+            PORT->Group[STROBE_PORT_GROUP].OUTSET.reg = 1U << STROBE_PIN; \
+\
+            /* datasheet says 700 +/- 150 ns, empirically > 500 ns */ \
+            asm volatile(NOPS_166NS NOPS_166NS NOPS_166NS NOPS_166NS :::); \
+\
+            /* lower pin */ \
+            PORT->Group[STROBE_PORT_GROUP].OUTCLR.reg = 1U << STROBE_PIN; \
+\
+            /* datasheet says 600 +/- 150 ns, empirically > 16 ns */ \
+            asm volatile(NOPS_166NS NOPS_166NS NOPS_166NS :::); \
+        } else { \
+            PORT->Group[STROBE_PORT_GROUP].OUTSET.reg = 1U << STROBE_PIN; \
+\
+            /* datasheet says 350 +/- 150 ns, empirically > 33 and < 500 ns */ \
+            asm volatile(NOPS_166NS NOPS_166NS :::); \
+\
+            PORT->Group[STROBE_PORT_GROUP].OUTCLR.reg = 1U << STROBE_PIN; \
+\
+            /* datasheet says 800 +/- 150 ns, empirically > 550 ns */ \
+            asm volatile(NOPS_166NS NOPS_166NS NOPS_166NS NOPS_166NS :::); \
+        } \
+\
+    __enable_irq(); \
+}
 
-            /* datasheet says 800 +/- 150 ns, empirically > 550 ns */
-            asm volatile(NOPS_166NS NOPS_166NS NOPS_166NS NOPS_166NS :::);
-        }
+DEFINE_SINGLE_WS2812_SET_GRB(single_ws2812_set_grb_at_48MHz, NOPS_166NS_AT_48MHZ)
+DEFINE_SINGLE_WS2812_SET_GRB(single_ws2812_set_grb_at_120MHz, NOPS_166NS_AT_120MHZ)
 
-    __enable_irq();
+static void single_ws2812_set_grb(const uint32_t grb) {
+    /* the write takes 30 us of wall time no matter how fast the cpu is, so the cheapest way to do
+     it is at 48 MHz, which needs only the dfll and not the much slower to lock and much hungrier
+     fdpll0. if main() has scaled the cpu down to 32 kHz, come up to 48 MHz just for this */
+    const unsigned long cpu_hz_before = cpu_clock_hz();
+    if (cpu_hz_before < 48000000) cpu_clock_set_48MHz();
+
+    if (cpu_clock_hz() >= 120000000)
+        single_ws2812_set_grb_at_120MHz(grb);
+    else
+        single_ws2812_set_grb_at_48MHz(grb);
+
+    if (cpu_hz_before < 48000000) cpu_clock_set_32kHz();
 }
 
 /* as a convenience, we can use the WS2812B to convey status by setting its value in between
  flashes to something other than just black */
 static unsigned idle_grb = 0;
 
-void TC3_Handler(void) {
-    if (TC3->COUNT8.INTFLAG.bit.MC0) {
+/* peripheral, irq, handler, clock and apb bit of whichever TC samd51_strobe_config.h chose */
+#define STROBE_CAT_(a, b, c) a##b##c
+#define STROBE_CAT(a, b, c) STROBE_CAT_(a, b, c)
+#define STROBE_TC_INSTANCE STROBE_CAT(TC, STROBE_TC, )
+#define STROBE_TC_IRQn STROBE_CAT(TC, STROBE_TC, _IRQn)
+#define STROBE_TC_GCLK_ID STROBE_CAT(TC, STROBE_TC, _GCLK_ID)
+#define STROBE_TC_Handler STROBE_CAT(TC, STROBE_TC, _Handler)
+#if STROBE_TC < 4
+#define STROBE_TC_APB_BIT MCLK->APBBMASK.bit.STROBE_CAT(TC, STROBE_TC, _)
+#elif STROBE_TC < 6
+#define STROBE_TC_APB_BIT MCLK->APBCMASK.bit.STROBE_CAT(TC, STROBE_TC, _)
+#else
+#define STROBE_TC_APB_BIT MCLK->APBDMASK.bit.STROBE_CAT(TC, STROBE_TC, _)
+#endif
+
+void STROBE_TC_Handler(void) {
+    if (STROBE_TC_INSTANCE->COUNT8.INTFLAG.bit.MC0) {
         /* clear flag so that interrupt doesn't re-fire */
-        TC3->COUNT8.INTFLAG.reg = (TC_INTFLAG_Type){ .bit.MC0 = 1 }.reg;
+        STROBE_TC_INSTANCE->COUNT8.INTFLAG.reg = (TC_INTFLAG_Type){ .bit.MC0 = 1 }.reg;
 
         single_ws2812_set_grb(idle_grb);
     }
-    else if (TC3->COUNT8.INTFLAG.bit.OVF) {
+    else if (STROBE_TC_INSTANCE->COUNT8.INTFLAG.bit.OVF) {
         /* clear flag so that interrupt doesn't re-fire */
-        TC3->COUNT8.INTFLAG.reg = (TC_INTFLAG_Type){ .bit.OVF = 1 }.reg;
+        STROBE_TC_INSTANCE->COUNT8.INTFLAG.reg = (TC_INTFLAG_Type){ .bit.OVF = 1 }.reg;
 
-        single_ws2812_set_grb(0xFFFFFF);
+        single_ws2812_set_grb(STROBE_GRB);
     }
 }
 
-static void tc3_init(void) {
+static void strobe_tc_init(void) {
     /* assume GCLK3 is one or the other 32 kHz reference, and we need to make sure it is
      enabled and allowed to run in stdby */
 #ifdef CRYSTALLESS
@@ -82,68 +118,238 @@ static void tc3_init(void) {
     while (!OSC32KCTRL->STATUS.bit.XOSC32KRDY);
 #endif
 
-    /* make sure the APB is enabled for TC3 */
-    MCLK->APBBMASK.bit.TC3_ = 1;
+    /* make sure the APB is enabled for the TC */
+    STROBE_TC_APB_BIT = 1;
 
-    /* use the 32 kHz clock peripheral as the source for TC3 */
-    GCLK->PCHCTRL[TC3_GCLK_ID].reg = (GCLK_PCHCTRL_Type) { .bit = {
+    /* use the 32 kHz clock peripheral as the source for the TC */
+    GCLK->PCHCTRL[STROBE_TC_GCLK_ID].reg = (GCLK_PCHCTRL_Type) { .bit = {
         .GEN = GCLK_PCHCTRL_GEN_GCLK3_Val,
         .CHEN = 1
     }}.reg;
     while (GCLK->SYNCBUSY.reg);
 
-    /* reset the TC3 peripheral */
-    TC3->COUNT8.CTRLA.bit.SWRST = 1;
-    while (TC3->COUNT8.SYNCBUSY.bit.SWRST);
+    /* reset the TC peripheral */
+    STROBE_TC_INSTANCE->COUNT8.CTRLA.bit.SWRST = 1;
+    while (STROBE_TC_INSTANCE->COUNT8.SYNCBUSY.bit.SWRST);
 
-    TC3->COUNT8.CTRLA.reg = (TC_CTRLA_Type) { .bit = {
+    STROBE_TC_INSTANCE->COUNT8.CTRLA.reg = (TC_CTRLA_Type) { .bit = {
         .MODE = TC_CTRLA_MODE_COUNT8_Val,
         .PRESCALER = TC_CTRLA_PRESCALER_DIV1024_Val, /* count at 32 per second */
         .RUNSTDBY = 1 /* run in stdby */
     }}.reg;
 
     /* set initial value to one tick before rollover */
-    TC3->COUNT8.COUNT.reg = 127;
+    STROBE_TC_INSTANCE->COUNT8.COUNT.reg = STROBE_PERIOD_TICKS - 1;
 
-    /* count to 4 seconds and roll over */
-    TC3->COUNT8.PER.reg = 127;
+    /* count to the strobe period and roll over */
+    STROBE_TC_INSTANCE->COUNT8.PER.reg = STROBE_PERIOD_TICKS - 1;
 
-    /* also fire the interrupt handler when the counter reaches 1 */
-    TC3->COUNT8.CC[0].reg = 1;
-    while (TC3->COUNT8.SYNCBUSY.bit.COUNT);
+    /* also fire the interrupt handler when the flash has been on for long enough */
+    STROBE_TC_INSTANCE->COUNT8.CC[0].reg = STROBE_ON_TICKS;
+    while (STROBE_TC_INSTANCE->COUNT8.SYNCBUSY.bit.COUNT);
 
     /* fire the interrupt handler when count equals 0 or CC0 */
-    TC3->COUNT8.INTENSET.reg = (TC_INTENSET_Type) { .bit.MC0 = 1, .bit.OVF = 1 }.reg;
-    NVIC_EnableIRQ(TC3_IRQn);
+    STROBE_TC_INSTANCE->COUNT8.INTENSET.reg = (TC_INTENSET_Type) { .bit.MC0 = 1, .bit.OVF = 1 }.reg;
+    NVIC_EnableIRQ(STROBE_TC_IRQn);
 
     /* enable the timer */
-    while (TC3->COUNT8.SYNCBUSY.reg);
-    TC3->COUNT8.CTRLA.bit.ENABLE = 1;
-    while (TC3->COUNT8.SYNCBUSY.bit.ENABLE);
+    while (STROBE_TC_INSTANCE->COUNT8.SYNCBUSY.reg);
+    STROBE_TC_INSTANCE->COUNT8.CTRLA.bit.ENABLE = 1;
+    while (STROBE_TC_INSTANCE->COUNT8.SYNCBUSY.bit.ENABLE);
 }
 
 void strobe_start(void) {
     /* prepare pin for output, initially low */
-    PORT->Group[1].DIRSET.reg = 1U << 3;
-    PORT->Group[1].OUTCLR.reg = 1U << 3;
+    PORT->Group[STROBE_PORT_GROUP].DIRSET.reg = 1U << STROBE_PIN;
+    PORT->Group[STROBE_PORT_GROUP].OUTCLR.reg = 1U << STROBE_PIN;
 
-    /* safe to elide delay here because it will be one tc3 tick before the first write */
-    tc3_init();
+    /* safe to elide delay here because it will be one tc tick before the first write */
+    strobe_tc_init();
 }
 
 void strobe_stop(void) {
-    PORT->Group[1].DIRCLR.reg = 1U << 3;
-    PORT->Group[1].OUTCLR.reg = 1U << 3;
+    PORT->Group[STROBE_PORT_GROUP].DIRCLR.reg = 1U << STROBE_PIN;
+    PORT->Group[STROBE_PORT_GROUP].OUTCLR.reg = 1U << STROBE_PIN;
 
-    TC3->COUNT8.CTRLA.bit.ENABLE = 0;
-    while (TC3->COUNT8.SYNCBUSY.bit.ENABLE);
+    STROBE_TC_INSTANCE->COUNT8.CTRLA.bit.ENABLE = 0;
+    while (STROBE_TC_INSTANCE->COUNT8.SYNCBUSY.bit.ENABLE);
 
-    GCLK->PCHCTRL[TC3_GCLK_ID].reg = (GCLK_PCHCTRL_Type) { .bit.CHEN = 0 }.reg;
+    GCLK->PCHCTRL[STROBE_TC_GCLK_ID].reg = (GCLK_PCHCTRL_Type) { .bit.CHEN = 0 }.reg;
     while (GCLK->SYNCBUSY.reg);
 
-    MCLK->APBBMASK.bit.TC3_ = 0;
+    STROBE_TC_APB_BIT = 0;
 }
 
+#ifdef STROBE_TRIGGER
+int strobe_trigger_set_timing(const unsigned long delay_us, const unsigned long on_us) {
+    if (delay_us < STROBE_TRIGGER_MIN_DELAY_US || on_us < STROBE_TRIGGER_MIN_ON_US ||
+        delay_us > STROBE_TRIGGER_MAX_US || on_us > STROBE_TRIGGER_MAX_US - delay_us)
+        return -1;
+
+    TC0->COUNT16.CC[0].reg = delay_us * STROBE_TRIGGER_TICKS_PER_US;
+    TC0->COUNT16.CC[1].reg = (delay_us + on_us) * STROBE_TRIGGER_TICKS_PER_US;
+    while (TC0->COUNT16.SYNCBUSY.reg);
+
+    return 0;
+}
+
+void strobe_trigger_start(void) {
+    /* everything below is clocked from the dfll, so make sure it is running */
+    if (cpu_clock_hz() < 48000000) cpu_clock_set_48MHz();
+
+    /* 48 MHz clock, same as what cpu_clock_set_120MHz() sets up */
+    GCLK->GENCTRL[1].reg = (GCLK_GENCTRL_Type) { .bit = { .SRC = GCLK_GENCTRL_SRC_DFLL_Val, .GENEN = 1, .IDC = 1 }}.reg;
+    while (GCLK->SYNCBUSY.reg & GCLK_SYNCBUSY_GENCTRL1);
+
+    /* prepare pin for output, initially low */
+    PORT->Group[STROBE_PORT_GROUP].DIRSET.reg = 1U << STROBE_PIN;
+    PORT->Group[STROBE_PORT_GROUP].OUTCLR.reg = 1U << STROBE_PIN;
+
+    /* route the trigger pin to the eic, which is peripheral function A */
+    PORT->Group[STROBE_TRIGGER_PORT_GROUP].PINCFG[STROBE_TRIGGER_PIN].reg = (PORT_PINCFG_Type) { .bit = { .PMUXEN = 1, .INEN = 1 }}.reg;
+#if STROBE_TRIGGER_PIN % 2
+    PORT->Group[STROBE_TRIGGER_PORT_GROUP].PMUX[STROBE_TRIGGER_PIN / 2].bit.PMUXO = 0;
+#else
+    PORT->Group[STROBE_TRIGGER_PORT_GROUP].PMUX[STROBE_TRIGGER_PIN / 2].bit.PMUXE = 0;
+#endif
+
+    /* make sure the APB is enabled for the eic, evsys and TC0 */
+    MCLK->APBAMASK.bit.EIC_ = 1;
+    MCLK->APBBMASK.bit.EVSYS_ = 1;
+    MCLK->APBAMASK.bit.TC0_ = 1;
+
+    /* clock the eic edge detection at 48 MHz, so that it adds only a couple dozen ns */
+    GCLK->PCHCTRL[EIC_GCLK_ID].reg = (GCLK_PCHCTRL_Type) { .bit = {
+        .GEN = GCLK_PCHCTRL_GEN_GCLK1_Val,
+        .CHEN = 1
+    }}.reg;
+    while (GCLK->SYNCBUSY.reg);
+
+    /* reset the eic peripheral */
+    EIC->CTRLA.bit.SWRST = 1;
+    while (EIC->SYNCBUSY.bit.SWRST);
+
+    /* detect the requested edge, and emit an event rather than an interrupt when it happens */
+    EIC->CONFIG[STROBE_TRIGGER_EXTINT / 8].reg = STROBE_TRIGGER_SENSE << (4 * (STROBE_TRIGGER_EXTINT % 8));
+    EIC->EVCTRL.reg = 1U << STROBE_TRIGGER_EXTINT;
+
+    EIC->CTRLA.bit.ENABLE = 1;
+    while (EIC->SYNCBUSY.bit.ENABLE);
+
+    /* evsys channel 0 carries the edge to TC0 on the asynchronous path, which needs no clock and
+     adds no synchronization delay */
+    EVSYS->Channel[0].CHANNEL.reg = (EVSYS_CHANNEL_Type) { .bit = {
+        .EVGEN = EVSYS_ID_GEN_EIC_EXTINT_0 + STROBE_TRIGGER_EXTINT,
+        .PATH = EVSYS_CHANNEL_PATH_ASYNCHRONOUS_Val
+    }}.reg;
+
+    /* user registers take the channel number plus one */
+    EVSYS->USER[EVSYS_ID_USER_TC0_EVU].reg = 0 + 1;
+
+    /* use the 48 MHz clock as the source for TC0 */
+    GCLK->PCHCTRL[TC0_GCLK_ID].reg = (GCLK_PCHCTRL_Type) { .bit = {
+        .GEN = GCLK_PCHCTRL_GEN_GCLK1_Val,
+        .CHEN = 1
+    }}.reg;
+    while (GCLK->SYNCBUSY.reg);
+
+    /* reset the TC0 peripheral */
+    TC0->COUNT16.CTRLA.bit.SWRST = 1;
+    while (TC0->COUNT16.SYNCBUSY.bit.SWRST);
+
+    TC0->COUNT16.CTRLA.reg = (TC_CTRLA_Type) { .bit = {
+        .MODE = TC_CTRLA_MODE_COUNT16_Val,
+        .PRESCALER = TC_CTRLA_PRESCALER_DIV16_Val, /* count at 3 per microsecond */
+        .PRESCSYNC = TC_CTRLA_PRESCSYNC_RESYNC_Val /* and restart the prescaler on each trigger */
+    }}.reg;
+
+    /* each trigger edge restarts the count from zero */
+    TC0->COUNT16.EVCTRL.reg = (TC_EVCTRL_Type) { .bit = {
+        .TCEI = 1,
+        .EVACT = TC_EVCTRL_EVACT_RETRIGGER_Val
+    }}.reg;
+
+    /* turn the flash on after the delay, and off again after the on time */
+    strobe_trigger_set_timing(STROBE_TRIGGER_DELAY_US, STROBE_TRIGGER_ON_US);
+
+    /* count up to the top once per trigger, then stop and wait for the next one */
+    TC0->COUNT16.CTRLBSET.reg = (TC_CTRLBSET_Type) { .bit.ONESHOT = 1 }.reg;
+    while (TC0->COUNT16.SYNCBUSY.bit.CTRLB);
+
+    /* set the interrupt flags on CC0 and CC1, but the interrupt is deliberately never enabled in
+     the nvic. with SEVONPEND, the pending state alone is enough to wake the cpu out of WFE, which
+     avoids both the isr entry and exit and the nondeterminism of whatever else it might preempt */
+    TC0->COUNT16.INTENSET.reg = (TC_INTENSET_Type) { .bit.MC0 = 1, .bit.MC1 = 1 }.reg;
+    NVIC_DisableIRQ(TC0_IRQn);
+    SCB->SCR |= SCB_SCR_SEVONPEND_Msk;
+
+    /* enable the timer, which starts it counting, so stop it until the first trigger */
+    TC0->COUNT16.CTRLA.bit.ENABLE = 1;
+    while (TC0->COUNT16.SYNCBUSY.bit.ENABLE);
+
+    TC0->COUNT16.CTRLBSET.reg = (TC_CTRLBSET_Type) { .bit.CMD = TC_CTRLBSET_CMD_STOP_Val }.reg;
+    while (TC0->COUNT16.SYNCBUSY.bit.CTRLB);
+
+    TC0->COUNT16.INTFLAG.reg = (TC_INTFLAG_Type) { .bit.MC0 = 1, .bit.MC1 = 1 }.reg;
+    NVIC_ClearPendingIRQ(TC0_IRQn);
+}
+
+void strobe_trigger_service(void) {
+    /* clear this first, so that if a flag gets set while we are in here, it pends again and the
+     next WFE returns immediately rather than missing it */
+    NVIC_ClearPendingIRQ(TC0_IRQn);
+
+    if (TC0->COUNT16.INTFLAG.bit.MC0) {
+        TC0->COUNT16.INTFLAG.reg = (TC_INTFLAG_Type){ .bit.MC0 = 1 }.reg;
+
+        single_ws2812_set_grb(STROBE_GRB);
+    }
+
+    if (TC0->COUNT16.INTFLAG.bit.MC1) {
+        TC0->COUNT16.INTFLAG.reg = (TC_INTFLAG_Type){ .bit.MC1 = 1 }.reg;
+
+        single_ws2812_set_grb(idle_grb);
+    }
+}
+
+void strobe_trigger_stop(void) {
+    PORT->Group[STROBE_PORT_GROUP].DIRCLR.reg = 1U << STROBE_PIN;
+    PORT->Group[STROBE_PORT_GROUP].OUTCLR.reg = 1U << STROBE_PIN;
+
+    PORT->Group[STROBE_TRIGGER_PORT_GROUP].PINCFG[STROBE_TRIGGER_PIN].reg = 0;
+
+    EIC->CTRLA.bit.ENABLE = 0;
+    while (EIC->SYNCBUSY.bit.ENABLE);
+
+    EVSYS->USER[EVSYS_ID_USER_TC0_EVU].reg = 0;
+    EVSYS->Channel[0].CHANNEL.reg = 0;
+
+    TC0->COUNT16.CTRLA.bit.ENABLE = 0;
+    while (TC0->COUNT16.SYNCBUSY.bit.ENABLE);
+
+    TC0->COUNT16.INTFLAG.reg = (TC_INTFLAG_Type) { .bit.MC0 = 1, .bit.MC1 = 1 }.reg;
+    NVIC_ClearPendingIRQ(TC0_IRQn);
+
+    /* nothing else of ours wants to be woken by a merely pending interrupt */
+    SCB->SCR &= ~SCB_SCR_SEVONPEND_Msk;
+
+    GCLK->PCHCTRL[TC0_GCLK_ID].reg = (GCLK_PCHCTRL_Type) { .bit.CHEN = 0 }.reg;
+    GCLK->PCHCTRL[EIC_GCLK_ID].reg = (GCLK_PCHCTRL_Type) { .bit.CHEN = 0 }.reg;
+    while (GCLK->SYNCBUSY.reg);
+
+    /* gclk1 is also the 48 MHz clock cpu_clock_set_120MHz() sets up, so only turn it off if we
+     were the ones who needed it */
+    if (cpu_clock_hz() < 120000000) {
+        GCLK->GENCTRL[1].reg = 0;
+        while (GCLK->SYNCBUSY.reg & GCLK_SYNCBUSY_GENCTRL1);
+    }
+
+    MCLK->APBAMASK.bit.TC0_ = 0;
+    MCLK->APBBMASK.bit.EVSYS_ = 0;
+    MCLK->APBAMASK.bit.EIC_ = 0;
+}
+#endif
+
 void strobe_set_idle_color(unsigned idle_grb_input) {
     if (idle_grb_input != idle_grb)
         single_ws2812_set_grb(idle_grb_input);
@@ -1,3 +1,17 @@
 void strobe_start(void);
 void strobe_stop(void);
 void strobe_set_idle_color(unsigned);
+
+#ifdef STROBE_TRIGGER
+/* alternative to strobe_start() which flashes on an external trigger edge, only built with
+ -DSTROBE_TRIGGER, see samd51_strobe_config.h. the cpu must stay at 48 MHz or faster while this
+ is running, and strobe_trigger_service() must be called every time WFE returns */
+void strobe_trigger_start(void);
+void strobe_trigger_service(void);
+void strobe_trigger_stop(void);
+
+/* change the delay and on time after strobe_trigger_start(), returns nonzero and changes nothing
+ if they are outside the limits in samd51_strobe_config.h. takes effect immediately, so should
+ be called between flashes, otherwise the flash in progress may be cut short or extended */
+int strobe_trigger_set_timing(unsigned long delay_us, unsigned long on_us);
+#endif
@@ -17,6 +17,8 @@
 #include <samd51/include/samd51.h>
 #endif
 
+#include "samd51_init.h"
+
 /* symbols provided by linker script, referred to within Reset_Handler and exception_table.
  deviation from cmsis: these are the symbol names provided by the adafruit linker script,
  with which we want to remain compatible */
@@ -418,6 +420,13 @@ __attribute__((used, section(".isr_vector"))) const DeviceVectors exception_tabl
  and 1 MHz respectively, we don't, but we should probably not reuse those two GCLKs for
  other clock frequencies */
 
+/* frequency gclk0 is currently running at, as set by the cpu_clock_set_*() functions */
+static unsigned long cpu_hz = 0;
+
+unsigned long cpu_clock_hz(void) {
+    return cpu_hz;
+}
+
 static void switch_cpu_to_32kHz(void) {
 #ifdef CRYSTALLESS
     OSC32KCTRL->OSCULP32K.bit.EN32K = 1;
@@ -447,9 +456,13 @@ static void switch_cpu_to_32kHz(void) {
     /* temporarily use the ulp oscillator for generic clock 0 */
     GCLK->GENCTRL[0].reg = (GCLK_GENCTRL_Type) { .bit = { .SRC = GCLK_GENCTRL_SRC_OSCULP32K_Val, .GENEN = 1 }}.reg;
     while (GCLK->SYNCBUSY.reg & GCLK_SYNCBUSY_GENCTRL0);
+
+    /* the fast oscillators are still in whatever state the bootloader left them in, so make sure
+     cpu_clock_set_*() does not assume either of them is already usable */
+    cpu_hz = 0;
 }
 
-static void switch_cpu_from_32kHz_to_fast(void) {
+static void dfll_enable(void) {
     /* bring up dfll in open loop mode */
 
     OSCCTRL->DFLLCTRLA.reg = 0;
@@ -470,37 +483,122 @@ static void switch_cpu_from_32kHz_to_fast(void) {
 
     OSCCTRL->DFLLCTRLB.reg = (OSCCTRL_DFLLCTRLB_Type) { .bit = { .WAITLOCK = 1, .CCDIS = 1 }}.reg;
     while (!OSCCTRL->STATUS.bit.DFLLRDY);
+}
+
+static void fdpll0_disable(void) {
+    OSCCTRL->Dpll[0].DPLLCTRLA.reg = 0;
+    while (OSCCTRL->Dpll[0].DPLLSYNCBUSY.bit.ENABLE);
+
+    GCLK->GENCTRL[5].reg = 0;
+    while (GCLK->SYNCBUSY.bit.GENCTRL5);
+}
+
+static void cpu_clock_set_32kHz_with_irqs_masked(void) {
+    if (32768 == cpu_hz) return;
+
+    /* run the cpu from whichever 32 kHz oscillator is also feeding generic clock generator 3 */
+#ifndef CRYSTALLESS
+    GCLK->GENCTRL[0].reg = (GCLK_GENCTRL_Type) { .bit = { .SRC = GCLK_GENCTRL_SRC_XOSC32K_Val, .GENEN = 1 }}.reg;
+#else
+    GCLK->GENCTRL[0].reg = (GCLK_GENCTRL_Type) { .bit = { .SRC = GCLK_GENCTRL_SRC_OSCULP32K_Val, .GENEN = 1 }}.reg;
+#endif
+    while (GCLK->SYNCBUSY.reg & GCLK_SYNCBUSY_GENCTRL0);
+
+    /* nothing else of ours uses the fast oscillators, so shut them off rather than leaving them
+     running at full current underneath a cpu that is not using them */
+    if (120000000 == cpu_hz) fdpll0_disable();
+
+    /* gclk1 may have been left on by cpu_clock_set_120MHz() or strobe_trigger_start(), even if
+     we have since come down through 48 MHz, and must not be left on a stopped dfll */
+    GCLK->GENCTRL[1].reg = 0;
+    while (GCLK->SYNCBUSY.reg & GCLK_SYNCBUSY_GENCTRL1);
+
+    OSCCTRL->DFLLCTRLA.reg = 0;
+    while (OSCCTRL->DFLLSYNC.reg & OSCCTRL_DFLLSYNC_ENABLE);
+
+    cpu_hz = 32768;
+}
+
+static void cpu_clock_set_48MHz_with_irqs_masked(void) {
+    if (48000000 == cpu_hz) return;
+
+    /* the dfll is only known to be up and in open loop mode if we are coming from 48 or 120 MHz */
+    if (cpu_hz < 48000000) dfll_enable();
 
-    if (48000000 == F_CPU)
     /* use the 48 MHz clock for the cpu */
-        GCLK->GENCTRL[0].reg = (GCLK_GENCTRL_Type) { .bit = { .SRC = GCLK_GENCTRL_SRC_DFLL_Val, .GENEN = 1 }}.reg;
-    else {
-        /* divide by 48 to get a 1 MHz clock for generic clock generator 5 */
-        GCLK->GENCTRL[5].reg = (GCLK_GENCTRL_Type) { .bit = { .SRC = GCLK_GENCTRL_SRC_DFLL_Val, .GENEN = 1, .DIV = 48U }}.reg;
-        while (GCLK->SYNCBUSY.bit.GENCTRL5);
+    GCLK->GENCTRL[0].reg = (GCLK_GENCTRL_Type) { .bit = { .SRC = GCLK_GENCTRL_SRC_DFLL_Val, .GENEN = 1 }}.reg;
+    while (GCLK->SYNCBUSY.reg & GCLK_SYNCBUSY_GENCTRL0);
+
+    /* nothing else of ours uses fdpll0, so do not leave it running */
+    if (120000000 == cpu_hz) fdpll0_disable();
+
+    cpu_hz = 48000000;
+}
+
+static void cpu_clock_set_120MHz_with_irqs_masked(void) {
+    if (120000000 == cpu_hz) return;
+
+    /* the dfll is only known to be up and in open loop mode if we are coming from 48 or 120 MHz */
+    if (cpu_hz < 48000000) dfll_enable();
 
-        /* set up fdpll0 at F_CPU (120 MHz) */
-        GCLK->PCHCTRL[OSCCTRL_GCLK_ID_FDPLL0].reg = (GCLK_PCHCTRL_Type) { .bit = { .GEN = GCLK_PCHCTRL_GEN_GCLK5_Val, .CHEN = 1 }}.reg;
+    /* divide by 48 to get a 1 MHz clock for generic clock generator 5 */
+    GCLK->GENCTRL[5].reg = (GCLK_GENCTRL_Type) { .bit = { .SRC = GCLK_GENCTRL_SRC_DFLL_Val, .GENEN = 1, .DIV = 48U }}.reg;
+    while (GCLK->SYNCBUSY.bit.GENCTRL5);
 
-        OSCCTRL->Dpll[0].DPLLRATIO.reg = (OSCCTRL_DPLLRATIO_Type) { .bit = { .LDRFRAC = 0x00, .LDR = (F_CPU - 500000) / 1000000 }}.reg;
-        while (OSCCTRL->Dpll[0].DPLLSYNCBUSY.bit.DPLLRATIO);
+    /* set up fdpll0 at 120 MHz */
+    GCLK->PCHCTRL[OSCCTRL_GCLK_ID_FDPLL0].reg = (GCLK_PCHCTRL_Type) { .bit = { .GEN = GCLK_PCHCTRL_GEN_GCLK5_Val, .CHEN = 1 }}.reg;
 
-        /* must use lbypass due to chip errata 2.13.1 */
-        OSCCTRL->Dpll[0].DPLLCTRLB.reg = (OSCCTRL_DPLLCTRLB_Type) { .bit = { .REFCLK = OSCCTRL_DPLLCTRLB_REFCLK_GCLK_Val, . LBYPASS = 1 }}.reg;
+    OSCCTRL->Dpll[0].DPLLRATIO.reg = (OSCCTRL_DPLLRATIO_Type) { .bit = { .LDRFRAC = 0x00, .LDR = (120000000 - 500000) / 1000000 }}.reg;
+    while (OSCCTRL->Dpll[0].DPLLSYNCBUSY.bit.DPLLRATIO);
 
-        OSCCTRL->Dpll[0].DPLLCTRLA.reg = (OSCCTRL_DPLLCTRLA_Type) { .bit.ENABLE = 1 }.reg;
-        while (OSCCTRL->Dpll[0].DPLLSTATUS.bit.CLKRDY == 0 || OSCCTRL->Dpll[0].DPLLSTATUS.bit.LOCK == 0);
+    /* must use lbypass due to chip errata 2.13.1 */
+    OSCCTRL->Dpll[0].DPLLCTRLB.reg = (OSCCTRL_DPLLCTRLB_Type) { .bit = { .REFCLK = OSCCTRL_DPLLCTRLB_REFCLK_GCLK_Val, . LBYPASS = 1 }}.reg;
 
-        /* 48 MHz clock, required for usb and many other things */
-        GCLK->GENCTRL[1].reg = (GCLK_GENCTRL_Type) { .bit = { .SRC = GCLK_GENCTRL_SRC_DFLL_Val, .GENEN = 1, .IDC = 1 }}.reg;
-        while (GCLK->SYNCBUSY.reg & GCLK_SYNCBUSY_GENCTRL1);
+    OSCCTRL->Dpll[0].DPLLCTRLA.reg = (OSCCTRL_DPLLCTRLA_Type) { .bit.ENABLE = 1 }.reg;
+    while (OSCCTRL->Dpll[0].DPLLSTATUS.bit.CLKRDY == 0 || OSCCTRL->Dpll[0].DPLLSTATUS.bit.LOCK == 0);
 
-        /* use the 120 MHz clock for the cpu */
-        GCLK->GENCTRL[0].reg = (GCLK_GENCTRL_Type) { .bit = { .SRC = GCLK_GENCTRL_SRC_DPLL0_Val, .GENEN = 1, .IDC = 1 }}.reg;
-    }
+    /* 48 MHz clock, required for usb and many other things */
+    GCLK->GENCTRL[1].reg = (GCLK_GENCTRL_Type) { .bit = { .SRC = GCLK_GENCTRL_SRC_DFLL_Val, .GENEN = 1, .IDC = 1 }}.reg;
+    while (GCLK->SYNCBUSY.reg & GCLK_SYNCBUSY_GENCTRL1);
 
+    /* use the 120 MHz clock for the cpu */
+    GCLK->GENCTRL[0].reg = (GCLK_GENCTRL_Type) { .bit = { .SRC = GCLK_GENCTRL_SRC_DPLL0_Val, .GENEN = 1, .IDC = 1 }}.reg;
     while (GCLK->SYNCBUSY.reg & GCLK_SYNCBUSY_GENCTRL0);
 
+    cpu_hz = 120000000;
+}
+
+/* the transitions above read and write cpu_hz, and isrs may call these too (the strobe does, to
+ get up to 48 MHz for each ws2812 write), so each transition must be atomic with respect to
+ them. this masks interrupts for the duration, which is tens of us when fdpll0 has to lock */
+void cpu_clock_set_32kHz(void) {
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    cpu_clock_set_32kHz_with_irqs_masked();
+    __set_PRIMASK(primask);
+}
+
+void cpu_clock_set_48MHz(void) {
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    cpu_clock_set_48MHz_with_irqs_masked();
+    __set_PRIMASK(primask);
+}
+
+void cpu_clock_set_120MHz(void) {
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    cpu_clock_set_120MHz_with_irqs_masked();
+    __set_PRIMASK(primask);
+}
+
+static void switch_cpu_from_32kHz_to_fast(void) {
+    /* F_CPU only determines the speed we boot at, main() is free to change it at runtime */
+    if (48000000 == F_CPU)
+        cpu_clock_set_48MHz();
+    else
+        cpu_clock_set_120MHz();
+
     /* with no divider */
     MCLK->CPUDIV.reg = MCLK_CPUDIV_DIV_DIV1;
 }
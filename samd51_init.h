@@ -0,0 +1,7 @@
+/* runtime cpu clock scaling, usable any time after SystemInit(), from main or isr context. each
+ transition masks interrupts while it runs. note that anything else clocked from gclk0 will also
+ see the change. the 32 kHz mode shuts off the dfll, fdpll0 and gclk1 entirely */
+void cpu_clock_set_32kHz(void);
+void cpu_clock_set_48MHz(void);
+void cpu_clock_set_120MHz(void);
+unsigned long cpu_clock_hz(void);
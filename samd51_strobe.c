@@ -9,15 +9,41 @@
 #endif
 
 #include "samd51_feather_m4_strobe.h"
+#include "samd51_init.h"
+#include "samd51_strobe_config.h"
 
 int main(void) {
     /* explicitly disable usb if the bootloader left it enabled */
     USB->DEVICE.CTRLA.bit.ENABLE = 0;
 
+#ifdef STROBE_TRIGGER
+    /* idle rather than standby, so that the dfll keeps running and leaving WFE takes a few
+     cycles rather than the several microseconds of restarting the fast clocks */
+    PM->SLEEPCFG.bit.SLEEPMODE = PM_SLEEPCFG_SLEEPMODE_IDLE_Val;
+
+    strobe_trigger_start();
+
+    /* every flash on and off pends TC0_IRQn, which wakes us here without taking an isr */
+    while (1) {
+        __WFE();
+        strobe_trigger_service();
+    }
+#else
     /* reduce idle power consumption since we are just going to sleep forever outside isr */
     PM->SLEEPCFG.bit.SLEEPMODE = PM_SLEEPCFG_SLEEPMODE_STANDBY_Val;
 
     strobe_start();
 
+    /* see samd51_strobe_config.h for why this defaults to 48 MHz. if it is 32 kHz, the strobe
+     brings the cpu up to 48 MHz only for the duration of each ws2812 write */
+#if 32768 == STROBE_CPU_HZ_BETWEEN_FLASHES
+    cpu_clock_set_32kHz();
+#elif 48000000 == STROBE_CPU_HZ_BETWEEN_FLASHES
+    cpu_clock_set_48MHz();
+#else
+    cpu_clock_set_120MHz();
+#endif
+
     while (1) __WFE();
+#endif
 }
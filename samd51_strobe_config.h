@@ -0,0 +1,134 @@
+/* compile-time configuration of the strobe. anything here can be overridden from the command
+ line or the Makefile, e.g. -DSTROBE_PIN=2, and everything ends up as a literal in the register
+ writes, so there is no cost relative to hardcoding the values */
+
+/* which TC flashes the strobe. TC0 is taken by trigger mode, and TC1 shares its peripheral
+ clock channel with TC0, so this must be TC2 or above. it counts the 32 kHz oscillator divided
+ by 1024 */
+#ifndef STROBE_TC
+#define STROBE_TC 3
+#endif
+
+#define STROBE_TICKS_PER_SECOND 32
+
+/* port group (0 for PA, 1 for PB, etc) and pin of the ws2812 data line. default is the neopixel
+ on the feather m4. the Makefile sets these per board, and refuses to build for boards that do
+ not have a ws2812 of their own unless they are given explicitly */
+#ifndef STROBE_PORT_GROUP
+#define STROBE_PORT_GROUP 1
+#endif
+
+#ifndef STROBE_PIN
+#define STROBE_PIN 3
+#endif
+
+/* time between flashes, and how long each flash lasts, in ticks of the TC */
+#ifndef STROBE_PERIOD_TICKS
+#define STROBE_PERIOD_TICKS (4 * STROBE_TICKS_PER_SECOND)
+#endif
+
+#ifndef STROBE_ON_TICKS
+#define STROBE_ON_TICKS 1
+#endif
+
+/* colour of the flash itself, as a 24-bit GRB triplet */
+#ifndef STROBE_GRB
+#define STROBE_GRB 0xFFFFFF
+#endif
+
+/* cpu speed main() leaves the cpu at between flashes, one of 32768, 48000000 or 120000000. the
+ dfll and fdpll0 stop in standby regardless, so running slower while asleep saves nothing, and
+ 32 kHz makes every isr entry and clock transition take milliseconds at full active current.
+ 48 MHz is the slowest speed that can do the ws2812 write, so it needs no transition at all */
+#ifndef STROBE_CPU_HZ_BETWEEN_FLASHES
+#define STROBE_CPU_HZ_BETWEEN_FLASHES 48000000
+#endif
+
+/* how many TCs and port groups the part has, from the device header when it has been included
+ first. the host-side power model has no device header, and gets the most any samd51 has */
+#ifdef TC_INST_NUM
+#define STROBE_TC_NUM TC_INST_NUM
+#else
+#define STROBE_TC_NUM 8
+#endif
+
+#if defined(PIN_PD00) || !defined(TC_INST_NUM)
+#define STROBE_PORT_GROUP_NUM 4
+#elif defined(PIN_PC00)
+#define STROBE_PORT_GROUP_NUM 3
+#else
+#define STROBE_PORT_GROUP_NUM 2
+#endif
+
+_Static_assert(STROBE_PORT_GROUP < STROBE_PORT_GROUP_NUM, "this samd51 does not have that port group");
+_Static_assert(STROBE_TC >= 2 && STROBE_TC < STROBE_TC_NUM, "strobe must use a TC from TC2 up to the last one this samd51 has");
+_Static_assert(STROBE_PIN < 32, "pin must be within its port group");
+
+/* the TC runs in 8-bit mode, so PER = STROBE_PERIOD_TICKS - 1 has to fit */
+_Static_assert(STROBE_PERIOD_TICKS >= 2 && STROBE_PERIOD_TICKS <= 256, "period must be 2 to 256 ticks");
+_Static_assert(STROBE_ON_TICKS >= 1 && STROBE_ON_TICKS < STROBE_PERIOD_TICKS, "on time must be at least one tick and shorter than the period");
+_Static_assert(STROBE_GRB <= 0xFFFFFF, "flash colour must be a 24-bit GRB triplet");
+_Static_assert(STROBE_CPU_HZ_BETWEEN_FLASHES == 32768 || STROBE_CPU_HZ_BETWEEN_FLASHES == 48000000 || STROBE_CPU_HZ_BETWEEN_FLASHES == 120000000, "cpu speed between flashes must be one of the cpu_clock_set_*() speeds");
+
+/* external trigger mode, enabled with -DSTROBE_TRIGGER. instead of flashing on STROBE_TC, an
+ edge on the trigger pin retriggers TC0 via the event system, and TC0 reaching the delay and
+ then the delay plus on time wakes the cpu out of WFE to write the flash and idle colours. no
+ isr is taken on the way from edge to light
+
+ latency and jitter below are unmeasured design estimates, and "make power_budget" prints them
+ for the configuration being built. trigger-to-light latency is the delay, plus about one
+ 21 ns cycle of the 48 MHz TC0 clock, since each trigger restarts the prescaler as well as the
+ count, plus a few cycles to leave WFE, plus the ~30 us ws2812 write and the ws2812's own reset
+ period before it latches (50 to 280 us depending on the part). jitter is that one TC0 clock
+ cycle plus a few cpu cycles, but only if every channel of STROBE_GRB is either off or full scale.
+ anything in between is pwm'd by the ws2812 itself, at a few hundred Hz on older parts, which
+ adds up to one pwm period of jitter to when light actually appears */
+
+#ifdef STROBE_TRIGGER
+/* default is D5 on the feather m4, which is PA16 and EXTINT0 */
+#ifndef STROBE_TRIGGER_PORT_GROUP
+#define STROBE_TRIGGER_PORT_GROUP 0
+#endif
+
+#ifndef STROBE_TRIGGER_PIN
+#define STROBE_TRIGGER_PIN 16
+#endif
+
+/* this holds for most but not all samd51 pins, check the pinout table if overriding the pin */
+#ifndef STROBE_TRIGGER_EXTINT
+#define STROBE_TRIGGER_EXTINT (STROBE_TRIGGER_PIN % 16)
+#endif
+
+/* which edge to trigger on, one of the EIC_CONFIG_SENSE0_*_Val constants */
+#ifndef STROBE_TRIGGER_SENSE
+#define STROBE_TRIGGER_SENSE EIC_CONFIG_SENSE0_RISE_Val
+#endif
+
+/* time from trigger edge to start of the flash, and how long each flash lasts, until changed
+ at runtime by strobe_trigger_set_timing() */
+#ifndef STROBE_TRIGGER_DELAY_US
+#define STROBE_TRIGGER_DELAY_US 1
+#endif
+
+#ifndef STROBE_TRIGGER_ON_US
+#define STROBE_TRIGGER_ON_US 10000
+#endif
+
+/* TC0 counts the 48 MHz dfll divided by 16 */
+#define STROBE_TRIGGER_TICKS_PER_US 3
+
+/* limits on delay and on time, also enforced at runtime by strobe_trigger_set_timing(). TC0
+ cannot match on the same tick it is retriggered, the on time must outlast the ws2812 write and
+ reset period, and the delay plus on time must fit in 16-bit TC0 */
+#define STROBE_TRIGGER_MIN_DELAY_US 1
+#define STROBE_TRIGGER_MIN_ON_US 300
+#define STROBE_TRIGGER_MAX_US (65535 / STROBE_TRIGGER_TICKS_PER_US)
+
+_Static_assert(STROBE_TRIGGER_PORT_GROUP < STROBE_PORT_GROUP_NUM, "this samd51 does not have that port group");
+_Static_assert(STROBE_TRIGGER_PIN < 32, "trigger pin must be within its port group");
+_Static_assert(!(STROBE_PORT_GROUP == STROBE_TRIGGER_PORT_GROUP && STROBE_PIN == STROBE_TRIGGER_PIN), "trigger pin cannot also be the strobe pin");
+_Static_assert(STROBE_TRIGGER_EXTINT < 16, "samd51 has 16 external interrupt lines");
+_Static_assert(STROBE_TRIGGER_DELAY_US >= STROBE_TRIGGER_MIN_DELAY_US, "TC0 cannot match on the same tick it is retriggered");
+_Static_assert(STROBE_TRIGGER_ON_US >= STROBE_TRIGGER_MIN_ON_US, "on time must outlast the ws2812 write and reset period");
+_Static_assert(STROBE_TRIGGER_DELAY_US + STROBE_TRIGGER_ON_US <= STROBE_TRIGGER_MAX_US, "delay plus on time must fit in 16-bit TC0");
+#endif
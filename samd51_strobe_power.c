@@ -0,0 +1,273 @@
+/* host-side energy model of the strobe firmware, built with "make power_budget" and run on the
+ build machine rather than the samd51. it walks through what main(), strobe_start() and
+ the STROBE_TC handler (or strobe_trigger_service() in trigger mode) do over one flash period, using
+ the same compile-time configuration as the firmware, and integrates current over time for
+ the cpu, the oscillators, standby, and the ws2812 itself
+
+ all current and timing figures below are approximate typical values at 3.3 V and 25 C, and
+ should be checked against the electrical characteristics chapter of the datasheet for the
+ specific part and silicon revision before being relied upon. the point of this is to compare
+ firmware changes against each other, not to predict absolute battery life to the percent */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "samd51_strobe_config.h"
+
+/* things about how the device is used rather than how the firmware is built */
+#ifndef POWER_SUPPLY_V
+#define POWER_SUPPLY_V 3.3
+#endif
+
+#ifndef POWER_BATTERY_MAH
+#define POWER_BATTERY_MAH 2000.0
+#endif
+
+/* whatever strobe_set_idle_color() will have been called with, if at all */
+#ifndef POWER_IDLE_GRB
+#define POWER_IDLE_GRB 0x000000
+#endif
+
+/* only used in trigger mode, where the firmware does not choose its own flash rate */
+#ifndef POWER_TRIGGERS_PER_DAY
+#define POWER_TRIGGERS_PER_DAY 21600.0
+#endif
+
+static const struct {
+    double standby_uA; /* standby, all ram retained, OSCULP32K running */
+    double idle_uA; /* idle, cpu clock gated, excluding oscillators */
+    double active_static_uA; /* active, independent of cpu frequency */
+    double active_uA_per_MHz; /* active, running from cache via the ldo */
+    double xosc32k_uA;
+    double dfll_uA;
+    double fdpll0_uA;
+    double tc_eic_evsys_uA; /* TC0 and EIC clocked at 48 MHz, for trigger mode */
+
+    double wake_from_standby_us;
+    double dfll_startup_us;
+    double fdpll0_lock_us;
+
+    double ws2812_quiescent_uA; /* drawn even when the ws2812 is black */
+    double ws2812_uA_per_channel; /* at full brightness, each of g, r, b */
+    double ws2812_reset_min_us, ws2812_reset_max_us; /* low time before latching, varies by part */
+    double ws2812_pwm_hz; /* internal pwm for anything between off and full scale, older parts */
+} datasheet = {
+    .standby_uA = 20.0,
+    .idle_uA = 400.0,
+    .active_static_uA = 200.0,
+    .active_uA_per_MHz = 90.0,
+    .xosc32k_uA = 0.4,
+    .dfll_uA = 300.0,
+    .fdpll0_uA = 600.0,
+    .tc_eic_evsys_uA = 150.0,
+
+    .wake_from_standby_us = 5.0,
+    .dfll_startup_us = 10.0,
+    .fdpll0_lock_us = 50.0,
+
+    .ws2812_quiescent_uA = 600.0,
+    .ws2812_uA_per_channel = 20000.0,
+    .ws2812_reset_min_us = 50.0,
+    .ws2812_reset_max_us = 280.0,
+    .ws2812_pwm_hz = 400.0,
+};
+
+/* rough cycle counts for the firmware itself, from reading the generated code */
+#define ISR_CYCLES 50 /* exception entry and exit, flag check and clear, call overhead */
+#define CLOCK_UP_CYCLES 60 /* cpu_clock_set_48MHz() from 32 kHz, not counting dfll startup */
+#define CLOCK_DOWN_CYCLES 20 /* cpu_clock_set_32kHz() from 48 MHz, after gclk0 is switched */
+#define SERVICE_CYCLES 30 /* leaving WFE through to the first bit of strobe_trigger_service()'s write */
+#define SERVICE_JITTER_CYCLES 12 /* variation in the above, mostly where in WFE exit we were */
+
+/* 24 bits at 1.25 us each, regardless of cpu speed */
+#define WS2812_WRITE_US 30.0
+
+struct energy {
+    double standby_uJ;
+    double cpu_uJ;
+    double osc_uJ;
+    double led_uJ;
+};
+
+static double total_uJ(const struct energy e) {
+    return e.standby_uJ + e.cpu_uJ + e.osc_uJ + e.led_uJ;
+}
+
+static double ws2812_uA(const unsigned grb) {
+    return datasheet.ws2812_quiescent_uA + datasheet.ws2812_uA_per_channel *
+        (((grb >> 16) & 0xFF) + ((grb >> 8) & 0xFF) + (grb & 0xFF)) / 255.0;
+}
+
+static double cpu_uA(const double cpu_hz) {
+    return datasheet.active_static_uA + datasheet.active_uA_per_MHz * cpu_hz * 1e-6;
+}
+
+static double xosc32k_uA(void) {
+#ifdef CRYSTALLESS
+    return 0.0;
+#else
+    return datasheet.xosc32k_uA;
+#endif
+}
+
+#ifndef STROBE_TRIGGER
+/* one wake of the STROBE_TC handler out of standby, including the ws2812 write, returning
+ microseconds spent awake and accumulating energy into e */
+static double periodic_wake(struct energy * e, const double cpu_hz_between_flashes) {
+    const double V = POWER_SUPPLY_V;
+    const double hz = cpu_hz_between_flashes;
+    double awake_us = 0, dfll_us = 0, fdpll0_us = 0;
+
+    /* regulator and flash come back before anything else happens */
+    e->cpu_uJ += V * cpu_uA(0) * datasheet.wake_from_standby_us * 1e-6;
+    awake_us += datasheet.wake_from_standby_us;
+
+    /* the dfll and fdpll0 do not run in standby, so whatever gclk0 was on has to come back
+     before the isr can start executing */
+    if (hz >= 48e6) {
+        e->cpu_uJ += V * cpu_uA(0) * datasheet.dfll_startup_us * 1e-6;
+        dfll_us += datasheet.dfll_startup_us;
+        awake_us += datasheet.dfll_startup_us;
+    }
+    if (hz >= 120e6) {
+        e->cpu_uJ += V * cpu_uA(0) * datasheet.fdpll0_lock_us * 1e-6;
+        dfll_us += datasheet.fdpll0_lock_us;
+        fdpll0_us += datasheet.fdpll0_lock_us;
+        awake_us += datasheet.fdpll0_lock_us;
+    }
+
+    /* isr bookkeeping at whatever speed the cpu woke at */
+    const double isr_us = ISR_CYCLES / hz * 1e6;
+    e->cpu_uJ += V * cpu_uA(hz) * isr_us * 1e-6;
+    if (hz >= 48e6) dfll_us += isr_us;
+    if (hz >= 120e6) fdpll0_us += isr_us;
+    awake_us += isr_us;
+
+    double write_hz = hz;
+    if (hz < 48e6) {
+        /* single_ws2812_set_grb() brings the cpu up to 48 MHz and back down around the write */
+        const double up_us = CLOCK_UP_CYCLES / hz * 1e6 + datasheet.dfll_startup_us;
+        e->cpu_uJ += V * cpu_uA(hz) * up_us * 1e-6;
+        dfll_us += datasheet.dfll_startup_us;
+        awake_us += up_us;
+
+        /* cpu_clock_set_32kHz() switches gclk0 first, so the rest of it runs at 32 kHz */
+        const double down_us = CLOCK_DOWN_CYCLES / hz * 1e6;
+        e->cpu_uJ += V * cpu_uA(hz) * down_us * 1e-6;
+        dfll_us += down_us;
+        awake_us += down_us;
+
+        write_hz = 48e6;
+    }
+
+    e->cpu_uJ += V * cpu_uA(write_hz) * WS2812_WRITE_US * 1e-6;
+    dfll_us += WS2812_WRITE_US;
+    if (write_hz >= 120e6) fdpll0_us += WS2812_WRITE_US;
+    awake_us += WS2812_WRITE_US;
+
+    e->osc_uJ += V * (datasheet.dfll_uA * dfll_us + datasheet.fdpll0_uA * fdpll0_us) * 1e-6;
+
+    return awake_us;
+}
+
+/* one full period of the strobe driven by STROBE_TC, as started by strobe_start() from main() */
+static struct energy periodic_flash(const double cpu_hz_between_flashes) {
+    const double V = POWER_SUPPLY_V;
+    const double period_s = (double)STROBE_PERIOD_TICKS / STROBE_TICKS_PER_SECOND;
+    const double on_s = (double)STROBE_ON_TICKS / STROBE_TICKS_PER_SECOND;
+    struct energy e = { 0 };
+
+    /* the STROBE_TC handler wakes twice per period, once for the flash and once to go back to idle */
+    const double awake_us = periodic_wake(&e, cpu_hz_between_flashes) + periodic_wake(&e, cpu_hz_between_flashes);
+    const double standby_s = period_s - awake_us * 1e-6;
+
+    e.standby_uJ += V * (datasheet.standby_uA + xosc32k_uA()) * standby_s;
+
+    /* the 32 kHz oscillator also runs while awake, lump it in with the other oscillators */
+    e.osc_uJ += V * xosc32k_uA() * awake_us * 1e-6;
+
+    e.led_uJ += V * ws2812_uA(STROBE_GRB) * on_s;
+    e.led_uJ += V * ws2812_uA(POWER_IDLE_GRB) * (period_s - on_s);
+
+    return e;
+}
+
+#else
+/* one trigger of the EIC/EVSYS/TC0 strobe, as started by strobe_trigger_start() from main(),
+ spread over the average time between triggers */
+static struct energy triggered_flash(const double cpu_hz) {
+    const double V = POWER_SUPPLY_V;
+    const double period_s = 86400.0 / POWER_TRIGGERS_PER_DAY;
+    const double on_s = STROBE_TRIGGER_ON_US * 1e-6;
+    struct energy e = { 0 };
+
+    /* two wakes out of idle per trigger, each leaving WFE into strobe_trigger_service() and doing
+     a ws2812 write, with no isr and no clock restarts */
+    const double awake_us = 2.0 * (SERVICE_CYCLES / cpu_hz * 1e6 + WS2812_WRITE_US);
+    e.cpu_uJ += V * cpu_uA(cpu_hz) * awake_us * 1e-6;
+
+    /* the cpu sleeps in idle, never standby, and the dfll, TC0 and EIC run continuously */
+    e.standby_uJ += V * datasheet.idle_uA * (period_s - awake_us * 1e-6);
+    e.osc_uJ += V * (datasheet.dfll_uA + datasheet.tc_eic_evsys_uA + xosc32k_uA()) * period_s;
+    if (cpu_hz >= 120e6)
+        e.osc_uJ += V * datasheet.fdpll0_uA * period_s;
+
+    e.led_uJ += V * ws2812_uA(STROBE_GRB) * on_s;
+    e.led_uJ += V * ws2812_uA(POWER_IDLE_GRB) * (period_s - on_s);
+
+    return e;
+}
+
+/* trigger-to-light latency and jitter, from the same figures as the energy model */
+static void print_trigger_latency(const double cpu_hz) {
+    /* each trigger restarts TC0's prescaler, so only the edge's position within one cycle of its
+     48 MHz clock is left, rather than within a whole tick */
+    const double tc_clock_us = 1.0 / 48.0;
+    const double fixed_us = STROBE_TRIGGER_DELAY_US + SERVICE_CYCLES / cpu_hz * 1e6 + WS2812_WRITE_US;
+
+    /* the ws2812 only pwms channels that are neither off nor full scale */
+    int pwm = 0;
+    for (unsigned shift = 0; shift < 24; shift += 8) {
+        const unsigned channel = (STROBE_GRB >> shift) & 0xFF;
+        if (channel != 0 && channel != 0xFF) pwm = 1;
+    }
+
+    const double jitter_us = tc_clock_us + SERVICE_JITTER_CYCLES / cpu_hz * 1e6 + (pwm ? 1e6 / datasheet.ws2812_pwm_hz : 0);
+
+    printf("trigger to light at %3.0f MHz: %.1f to %.1f us depending on ws2812 part, jitter %.2f us%s\n",
+           cpu_hz * 1e-6, fixed_us + datasheet.ws2812_reset_min_us, fixed_us + datasheet.ws2812_reset_max_us + jitter_us,
+           jitter_us, pwm ? " (including ws2812 pwm)" : "");
+}
+#endif
+
+static void print_row(const char * name, const struct energy e, const double flashes_per_day, const int is_this_build) {
+    const double joules_per_day = total_uJ(e) * 1e-6 * flashes_per_day;
+    const double mAh_per_day = joules_per_day / POWER_SUPPLY_V / 3.6;
+
+    printf("%-24s %9.1f %9.1f %9.1f %9.1f %9.1f   %8.3f %8.3f %8.1f%s\n", name,
+           e.standby_uJ, e.cpu_uJ, e.osc_uJ, e.led_uJ, total_uJ(e),
+           joules_per_day, mAh_per_day, POWER_BATTERY_MAH / mAh_per_day,
+           is_this_build ? "  <- this build" : "");
+}
+
+int main(void) {
+    printf("%-24s %9s %9s %9s %9s %9s   %8s %8s %8s\n", "per flash, uJ", "sleep", "cpu", "osc", "led", "total", "J/day", "mAh/day", "days");
+
+#ifdef STROBE_TRIGGER
+    const double flashes_per_day = POWER_TRIGGERS_PER_DAY;
+    print_row("triggered, 48 MHz", triggered_flash(48e6), flashes_per_day, 48000000 == F_CPU);
+    print_row("triggered, 120 MHz", triggered_flash(120e6), flashes_per_day, 48000000 != F_CPU);
+
+    printf("\nestimates from the figures in samd51_strobe_power.c, not measurements:\n");
+    print_trigger_latency(F_CPU);
+#else
+    /* main() leaves the cpu at STROBE_CPU_HZ_BETWEEN_FLASHES, the other rows show what the
+     other choices would cost */
+    const double flashes_per_day = 86400.0 * STROBE_TICKS_PER_SECOND / STROBE_PERIOD_TICKS;
+    print_row("fixed 48 MHz", periodic_flash(48e6), flashes_per_day, 48000000 == STROBE_CPU_HZ_BETWEEN_FLASHES);
+    print_row("fixed 120 MHz", periodic_flash(120e6), flashes_per_day, 120000000 == STROBE_CPU_HZ_BETWEEN_FLASHES);
+    print_row("scaled 32 kHz / 48 MHz", periodic_flash(32768), flashes_per_day, 32768 == STROBE_CPU_HZ_BETWEEN_FLASHES);
+#endif
+
+    return EXIT_SUCCESS;
+}